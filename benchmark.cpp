@@ -0,0 +1,145 @@
+#include "benchmark.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+static const char *const summaryMetrics[] = { "cpuMs", "gpuMs" };
+static const char *const summaryStats[] = { "mean", "p50", "p90", "p95", "p99", "max" };
+// Run parameters that must match for two reports to be comparable.
+static const char *const runInfoKeys[] = { "cameraPath", "frames", "warmupFrames", "windowSize", "renderer" };
+
+// Nearest-rank percentile of an ascending-sorted, non-empty list.
+static double percentile(const QVector<double> &sorted, double p)
+{
+    const int rank = int(std::ceil(p / 100.0 * sorted.size()));
+    return sorted.at(qBound(0, rank - 1, sorted.size() - 1));
+}
+
+static QJsonObject summarize(QVector<double> values)
+{
+    QJsonObject summary;
+    if (values.isEmpty())
+        return summary;
+
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double v : values)
+        sum += v;
+
+    summary.insert(QStringLiteral("mean"), sum / values.size());
+    summary.insert(QStringLiteral("p50"), percentile(values, 50));
+    summary.insert(QStringLiteral("p90"), percentile(values, 90));
+    summary.insert(QStringLiteral("p95"), percentile(values, 95));
+    summary.insert(QStringLiteral("p99"), percentile(values, 99));
+    summary.insert(QStringLiteral("max"), values.last());
+    return summary;
+}
+
+QJsonObject BenchmarkReport::toJson() const
+{
+    QVector<double> cpu;
+    QVector<double> gpu;
+    QJsonArray frames;
+    qint64 vertices = 0;
+
+    for (int i = 0; i < m_frames.size(); ++i) {
+        const FrameSample &s = m_frames.at(i);
+        QJsonObject o;
+        o.insert(QStringLiteral("frame"), i);
+        o.insert(QStringLiteral("cpuMs"), s.cpuMs);
+        if (s.gpuMs >= 0.0) {
+            o.insert(QStringLiteral("gpuMs"), s.gpuMs);
+            gpu.append(s.gpuMs);
+        }
+        o.insert(QStringLiteral("vertices"), s.vertices);
+        frames.append(o);
+        cpu.append(s.cpuMs);
+        vertices += s.vertices;
+    }
+
+    QJsonObject summary;
+    summary.insert(QStringLiteral("cpuMs"), summarize(cpu));
+    if (!gpu.isEmpty())
+        summary.insert(QStringLiteral("gpuMs"), summarize(gpu));
+    summary.insert(QStringLiteral("vertices"), vertices);
+
+    QJsonObject root;
+    root.insert(QStringLiteral("info"), m_info);
+    root.insert(QStringLiteral("frameCount"), m_frames.size());
+    root.insert(QStringLiteral("summary"), summary);
+    root.insert(QStringLiteral("frames"), frames);
+    return root;
+}
+
+bool BenchmarkReport::save(const QString &fileName, QString *errorString) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorString)
+            *errorString = file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson());
+    return true;
+}
+
+static bool loadReport(const QString &fileName, QJsonObject *summary, QJsonObject *info)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::cerr << qPrintable(fileName) << ": " << qPrintable(file.errorString()) << std::endl;
+        return false;
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject() || !doc.object().value(QStringLiteral("summary")).isObject()) {
+        std::cerr << qPrintable(fileName) << ": not a benchmark report" << std::endl;
+        return false;
+    }
+    *summary = doc.object().value(QStringLiteral("summary")).toObject();
+    *info = doc.object().value(QStringLiteral("info")).toObject();
+    return true;
+}
+
+int compareBenchmarkReports(const QString &baselineFileName, const QString &currentFileName,
+                            double thresholdPercent)
+{
+    QJsonObject baseline;
+    QJsonObject current;
+    QJsonObject baselineInfo;
+    QJsonObject currentInfo;
+    if (!loadReport(baselineFileName, &baseline, &baselineInfo)
+            || !loadReport(currentFileName, &current, &currentInfo))
+        return -1;
+
+    for (const char *key : runInfoKeys) {
+        const QString before = baselineInfo.value(QLatin1String(key)).toString();
+        const QString after = currentInfo.value(QLatin1String(key)).toString();
+        if (before != after)
+            std::cerr << "warning: runs differ in " << key << ": \"" << qPrintable(before)
+                      << "\" vs \"" << qPrintable(after) << '"' << std::endl;
+    }
+
+    int regressions = 0;
+    for (const char *metric : summaryMetrics) {
+        const QJsonObject b = baseline.value(QLatin1String(metric)).toObject();
+        const QJsonObject c = current.value(QLatin1String(metric)).toObject();
+        if (b.isEmpty() || c.isEmpty())
+            continue;
+
+        for (const char *stat : summaryStats) {
+            const double before = b.value(QLatin1String(stat)).toDouble();
+            const double after = c.value(QLatin1String(stat)).toDouble();
+            const double change = before > 0.0 ? (after - before) / before * 100.0 : 0.0;
+            const bool regressed = change > thresholdPercent;
+            if (regressed)
+                ++regressions;
+            std::cout << metric << '.' << stat << ": " << before << " -> " << after
+                      << " (" << (change >= 0.0 ? "+" : "") << change << "%)"
+                      << (regressed ? "  REGRESSION" : "") << std::endl;
+        }
+    }
+    return regressions;
+}
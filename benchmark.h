@@ -0,0 +1,48 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+// Timings for one rendered frame. gpuMs is negative when the context has
+// no timer queries (OpenGL ES, or a Qt built with -opengl es2).
+struct FrameSample
+{
+    double cpuMs = 0.0;
+    double gpuMs = -1.0;
+    qint64 vertices = 0;
+};
+
+// Collects per-frame samples during a camera-path replay and writes them,
+// together with percentile summaries, to a JSON report.
+class BenchmarkReport
+{
+public:
+    void clear() { m_frames.clear(); }
+    void reserve(int frames) { m_frames.reserve(frames); }
+    void addFrame(const FrameSample &sample) { m_frames.append(sample); }
+    // GPU times arrive a few frames late; this fills them in afterwards.
+    void setGpuTime(int frame, double ms) { m_frames[frame].gpuMs = ms; }
+    int frameCount() const { return m_frames.size(); }
+
+    // Free-form context stored alongside the results (renderer, path file, ...).
+    void setInfo(const QString &key, const QString &value) { m_info.insert(key, value); }
+
+    QJsonObject toJson() const;
+    bool save(const QString &fileName, QString *errorString = nullptr) const;
+
+private:
+    QVector<FrameSample> m_frames;
+    QJsonObject m_info;
+};
+
+// Compares the summaries of two reports written by BenchmarkReport::save()
+// and prints one line per metric. It warns when the runs differ in camera
+// path, frame or warm-up count, window size or renderer. A metric regresses when 'current' is more
+// than thresholdPercent slower than 'baseline'. Returns the number of
+// regressions, or -1 if either report could not be read.
+int compareBenchmarkReports(const QString &baselineFileName, const QString &currentFileName,
+                            double thresholdPercent);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,137 @@
+#include "camerapath.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+static QJsonArray vectorToJson(const QVector3D &v)
+{
+    return QJsonArray{ v.x(), v.y(), v.z() };
+}
+
+static QVector3D vectorFromJson(const QJsonValue &value)
+{
+    const QJsonArray a = value.toArray();
+    return QVector3D(a.at(0).toDouble(), a.at(1).toDouble(), a.at(2).toDouble());
+}
+
+template <typename T>
+static T catmullRom(const T &p0, const T &p1, const T &p2, const T &p3, float t)
+{
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    return 0.5f * ((2.0f * p1) + (p2 - p0) * t
+                   + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2
+                   + (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
+
+CameraPath::CameraPath()
+    : m_interpolation(Linear)
+{
+}
+
+bool CameraPath::load(const QString &fileName, QString *errorString)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorString)
+            *errorString = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        if (errorString)
+            *errorString = parseError.errorString();
+        return false;
+    }
+
+    const QJsonObject root = doc.object();
+    m_interpolation = root.value(QStringLiteral("interpolation")).toString() == QLatin1String("catmull-rom")
+            ? CatmullRom : Linear;
+
+    m_keyframes.clear();
+    const QJsonArray keyframes = root.value(QStringLiteral("keyframes")).toArray();
+    for (const QJsonValue &value : keyframes) {
+        const QJsonObject o = value.toObject();
+        CameraKeyframe k;
+        k.time = o.value(QStringLiteral("time")).toDouble();
+        k.eye = vectorFromJson(o.value(QStringLiteral("eye")));
+        k.yaw = o.value(QStringLiteral("yaw")).toDouble();
+        k.pitch = o.value(QStringLiteral("pitch")).toDouble();
+        m_keyframes.append(k);
+    }
+    std::stable_sort(m_keyframes.begin(), m_keyframes.end(),
+                     [](const CameraKeyframe &a, const CameraKeyframe &b) { return a.time < b.time; });
+
+    if (m_keyframes.isEmpty()) {
+        if (errorString)
+            *errorString = QStringLiteral("no keyframes");
+        return false;
+    }
+    m_fileName = fileName;
+    return true;
+}
+
+bool CameraPath::save(const QString &fileName, QString *errorString) const
+{
+    QJsonArray keyframes;
+    for (const CameraKeyframe &k : m_keyframes) {
+        QJsonObject o;
+        o.insert(QStringLiteral("time"), k.time);
+        o.insert(QStringLiteral("eye"), vectorToJson(k.eye));
+        o.insert(QStringLiteral("yaw"), k.yaw);
+        o.insert(QStringLiteral("pitch"), k.pitch);
+        keyframes.append(o);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("interpolation"),
+                m_interpolation == CatmullRom ? QStringLiteral("catmull-rom") : QStringLiteral("linear"));
+    root.insert(QStringLiteral("keyframes"), keyframes);
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorString)
+            *errorString = file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    return true;
+}
+
+CameraKeyframe CameraPath::sample(double time) const
+{
+    if (m_keyframes.isEmpty())
+        return CameraKeyframe();
+    if (time <= m_keyframes.first().time)
+        return m_keyframes.first();
+    if (time >= m_keyframes.last().time)
+        return m_keyframes.last();
+
+    // First keyframe strictly after 'time'; the one before it starts the segment.
+    auto next = std::upper_bound(m_keyframes.cbegin(), m_keyframes.cend(), time,
+                                 [](double t, const CameraKeyframe &k) { return t < k.time; });
+    const int i = int(next - m_keyframes.cbegin()) - 1;
+    const CameraKeyframe &k1 = m_keyframes.at(i);
+    const CameraKeyframe &k2 = m_keyframes.at(i + 1);
+    const double span = k2.time - k1.time;
+    const float t = span > 0.0 ? float((time - k1.time) / span) : 0.0f;
+
+    CameraKeyframe result;
+    result.time = time;
+    if (m_interpolation == CatmullRom) {
+        const CameraKeyframe &k0 = m_keyframes.at(qMax(i - 1, 0));
+        const CameraKeyframe &k3 = m_keyframes.at(qMin(i + 2, m_keyframes.size() - 1));
+        result.eye = catmullRom(k0.eye, k1.eye, k2.eye, k3.eye, t);
+        result.yaw = catmullRom(k0.yaw, k1.yaw, k2.yaw, k3.yaw, t);
+        result.pitch = catmullRom(k0.pitch, k1.pitch, k2.pitch, k3.pitch, t);
+    } else {
+        result.eye = k1.eye + (k2.eye - k1.eye) * t;
+        result.yaw = k1.yaw + (k2.yaw - k1.yaw) * t;
+        result.pitch = k1.pitch + (k2.pitch - k1.pitch) * t;
+    }
+    return result;
+}
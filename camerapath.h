@@ -0,0 +1,58 @@
+#ifndef CAMERAPATH_H
+#define CAMERAPATH_H
+
+#include <QString>
+#include <QVector>
+#include <QVector3D>
+
+// One camera pose on a path. 'time' is in milliseconds from the start of
+// the path; eye, yaw and pitch mirror GLWindow's camera state.
+struct CameraKeyframe
+{
+    double time = 0.0;
+    QVector3D eye;
+    float yaw = 0.0f;
+    float pitch = 0.0f;
+};
+
+// A time-ordered list of camera keyframes that can be sampled at any time,
+// loaded from and saved to a JSON file:
+//
+//   { "interpolation": "linear" | "catmull-rom",
+//     "keyframes": [ { "time": 0, "eye": [x, y, z], "yaw": 0, "pitch": 0 }, ... ] }
+class CameraPath
+{
+public:
+    enum Interpolation {
+        Linear,
+        CatmullRom
+    };
+
+    CameraPath();
+
+    bool load(const QString &fileName, QString *errorString = nullptr);
+    bool save(const QString &fileName, QString *errorString = nullptr) const;
+    // File the path was loaded from, empty for a path built in memory.
+    QString fileName() const { return m_fileName; }
+
+    void clear() { m_keyframes.clear(); }
+    // Keyframes must be appended in non-decreasing time order.
+    void addKeyframe(const CameraKeyframe &keyframe) { m_keyframes.append(keyframe); }
+    const QVector<CameraKeyframe> &keyframes() const { return m_keyframes; }
+    bool isEmpty() const { return m_keyframes.isEmpty(); }
+    double startTime() const { return m_keyframes.isEmpty() ? 0.0 : m_keyframes.first().time; }
+    double duration() const { return m_keyframes.isEmpty() ? 0.0 : m_keyframes.last().time - startTime(); }
+
+    Interpolation interpolation() const { return m_interpolation; }
+    void setInterpolation(Interpolation interpolation) { m_interpolation = interpolation; }
+
+    // Pose at 'time', clamped to the first and last keyframe.
+    CameraKeyframe sample(double time) const;
+
+private:
+    QVector<CameraKeyframe> m_keyframes;
+    Interpolation m_interpolation;
+    QString m_fileName;
+};
+
+#endif // CAMERAPATH_H
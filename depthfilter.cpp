@@ -0,0 +1,206 @@
+#include "depthfilter.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DEPTHFILTER_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define DEPTHFILTER_SSE2
+#endif
+
+// a * b + c, fused where the SIMD path fuses too so that vector lanes and
+// the scalar tail produce identical results.
+static inline float multiplyAdd(float a, float b, float c)
+{
+#if defined(DEPTHFILTER_NEON)
+    return std::fma(a, b, c);
+#else
+    return a * b + c;
+#endif
+}
+
+DepthFilter::DepthFilter()
+    : m_width(0),
+      m_height(0),
+      m_frames(0),
+      m_q(1e-4f),
+      m_r(1e-3f),
+      m_gate(3.0f),
+      m_lastFrameNs(0),
+      m_lastResets(0)
+{
+}
+
+void DepthFilter::reset()
+{
+    m_estimate.clear();
+    m_estimate.shrink_to_fit();
+    m_variance.clear();
+    m_variance.shrink_to_fit();
+    m_width = 0;
+    m_height = 0;
+    m_frames = 0;
+    m_lastResets = 0;
+}
+
+std::size_t DepthFilter::stateBytes() const
+{
+    return (m_estimate.capacity() + m_variance.capacity()) * sizeof(float);
+}
+
+void DepthFilter::process(const float *depth, float *filtered, int width, int height)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const int count = width * height;
+
+    if (width != m_width || height != m_height || m_frames == 0) {
+        m_width = width;
+        m_height = height;
+        m_estimate.resize(count);
+        m_variance.resize(count);
+        seed(depth, filtered, count);
+    } else {
+        update(depth, filtered, count);
+    }
+    ++m_frames;
+
+    m_lastFrameNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+}
+
+void DepthFilter::seed(const float *depth, float *filtered, int count)
+{
+    float *x = m_estimate.data();
+    float *p = m_variance.data();
+
+    int resets = 0;
+
+    for (int i = 0; i < count; ++i) {
+        const float z = depth[i];
+        const bool valid = z > 0.0f && z < std::numeric_limits<float>::infinity();
+        x[i] = valid ? z : 0.0f;
+        p[i] = m_r;
+        // Missing samples stay missing (NaN is clipped, not drawn at z = 0).
+        filtered[i] = z;
+        resets += valid;
+    }
+    m_lastResets = resets;
+}
+
+void DepthFilter::update(const float *depth, float *filtered, int count)
+{
+    float *x = m_estimate.data();
+    float *p = m_variance.data();
+    const float q = m_q;
+    const float r = m_r;
+    const float gate2 = m_gate * m_gate;
+    const float inf = std::numeric_limits<float>::infinity();
+    int resets = 0;
+    int i = 0;
+
+    // Per pixel: predict (P += q), then either blend the measurement with
+    // gain K = P / (P + r) or, when the innovation is outside the gate or
+    // there is no prior estimate yet, re-seed from the measurement. All
+    // branches are evaluated and merged with masks so lanes never diverge.
+    // A pixel that still has no estimate outputs the raw sample unchanged.
+#if defined(DEPTHFILTER_NEON)
+    const float32x4_t vq = vdupq_n_f32(q);
+    const float32x4_t vr = vdupq_n_f32(r);
+    const float32x4_t vgate2 = vdupq_n_f32(gate2);
+    const float32x4_t vzero = vdupq_n_f32(0.0f);
+    const float32x4_t vinf = vdupq_n_f32(inf);
+    uint32x4_t vresets = vdupq_n_u32(0);
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t z = vld1q_f32(depth + i);
+        const float32x4_t xi = vld1q_f32(x + i);
+        const float32x4_t pi = vaddq_f32(vld1q_f32(p + i), vq);
+
+        const uint32x4_t valid = vandq_u32(vcgtq_f32(z, vzero), vcltq_f32(z, vinf));
+        const float32x4_t y = vsubq_f32(z, xi);
+        const float32x4_t s = vaddq_f32(pi, vr);
+        const uint32x4_t outlier = vorrq_u32(vcgtq_f32(vmulq_f32(y, y), vmulq_f32(vgate2, s)),
+                                             vcleq_f32(xi, vzero));
+        const uint32x4_t reseed = vandq_u32(valid, outlier);
+        const uint32x4_t blend = vbicq_u32(valid, outlier);
+
+        const float32x4_t k = vdivq_f32(pi, s);
+        float32x4_t xn = vbslq_f32(blend, vfmaq_f32(xi, k, y), xi);
+        float32x4_t pn = vbslq_f32(blend, vfmsq_f32(pi, k, pi), pi);
+        xn = vbslq_f32(reseed, z, xn);
+        pn = vbslq_f32(reseed, vr, pn);
+
+        vst1q_f32(x + i, xn);
+        vst1q_f32(p + i, pn);
+        vst1q_f32(filtered + i, vbslq_f32(vcgtq_f32(xn, vzero), xn, z));
+        vresets = vsubq_u32(vresets, reseed);
+    }
+    resets += int(vaddvq_u32(vresets));
+#elif defined(DEPTHFILTER_SSE2)
+    const __m128 vq = _mm_set1_ps(q);
+    const __m128 vr = _mm_set1_ps(r);
+    const __m128 vgate2 = _mm_set1_ps(gate2);
+    const __m128 vzero = _mm_setzero_ps();
+    const __m128 vinf = _mm_set1_ps(inf);
+    __m128i vresets = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        const __m128 z = _mm_loadu_ps(depth + i);
+        const __m128 xi = _mm_loadu_ps(x + i);
+        const __m128 pi = _mm_add_ps(_mm_loadu_ps(p + i), vq);
+
+        const __m128 valid = _mm_and_ps(_mm_cmpgt_ps(z, vzero), _mm_cmplt_ps(z, vinf));
+        const __m128 y = _mm_sub_ps(z, xi);
+        const __m128 s = _mm_add_ps(pi, vr);
+        const __m128 outlier = _mm_or_ps(_mm_cmpgt_ps(_mm_mul_ps(y, y), _mm_mul_ps(vgate2, s)),
+                                         _mm_cmple_ps(xi, vzero));
+        const __m128 reseed = _mm_and_ps(valid, outlier);
+        const __m128 blend = _mm_andnot_ps(outlier, valid);
+
+        const __m128 k = _mm_div_ps(pi, s);
+        const __m128 xb = _mm_add_ps(xi, _mm_mul_ps(k, y));
+        const __m128 pb = _mm_sub_ps(pi, _mm_mul_ps(k, pi));
+        // keep = neither blended nor re-seeded, i.e. missing sample
+        const __m128 keep = _mm_andnot_ps(valid, _mm_castsi128_ps(_mm_set1_epi32(-1)));
+        const __m128 xn = _mm_or_ps(_mm_or_ps(_mm_and_ps(blend, xb), _mm_and_ps(reseed, z)),
+                                    _mm_and_ps(keep, xi));
+        const __m128 pn = _mm_or_ps(_mm_or_ps(_mm_and_ps(blend, pb), _mm_and_ps(reseed, vr)),
+                                    _mm_and_ps(keep, pi));
+
+        const __m128 estimated = _mm_cmpgt_ps(xn, vzero);
+
+        _mm_storeu_ps(x + i, xn);
+        _mm_storeu_ps(p + i, pn);
+        _mm_storeu_ps(filtered + i, _mm_or_ps(_mm_and_ps(estimated, xn), _mm_andnot_ps(estimated, z)));
+        vresets = _mm_sub_epi32(vresets, _mm_castps_si128(reseed));
+    }
+    alignas(16) int lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), vresets);
+    resets += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+    for (; i < count; ++i) {
+        const float z = depth[i];
+        const float pi = p[i] + q;
+        if (!(z > 0.0f && z < inf)) {
+            p[i] = pi;
+            filtered[i] = x[i] > 0.0f ? x[i] : z;
+            continue;
+        }
+        const float y = z - x[i];
+        const float s = pi + r;
+        if (y * y > gate2 * s || x[i] <= 0.0f) {
+            x[i] = z;
+            p[i] = r;
+            ++resets;
+        } else {
+            const float k = pi / s;
+            x[i] = multiplyAdd(k, y, x[i]);
+            p[i] = multiplyAdd(-k, pi, pi);
+        }
+        filtered[i] = x[i];
+    }
+
+    m_lastResets = resets;
+}
@@ -0,0 +1,66 @@
+#ifndef DEPTHFILTER_H
+#define DEPTHFILTER_H
+
+#include <cstddef>
+#include <vector>
+
+// Temporal per-pixel depth smoothing for streamed depth frames.
+//
+// Every pixel runs an independent 1D Kalman filter (constant-depth model)
+// whose state is kept as two planes, estimate and variance, so the update
+// loop processes several pixels per SIMD instruction. A pixel whose
+// innovation exceeds the reset threshold (in standard deviations) is
+// re-seeded from the measurement instead of being blended, which keeps
+// moving edges sharp. Non-positive or non-finite samples are treated as
+// missing: the pixel keeps its previous estimate, or passes the sample
+// through unchanged if it has never had a valid one.
+class DepthFilter
+{
+public:
+    DepthFilter();
+
+    // Variance added to every pixel per frame; larger values follow motion faster.
+    void setProcessNoise(float q) { m_q = q; }
+    float processNoise() const { return m_q; }
+    // Variance of a single sensor sample.
+    void setMeasurementNoise(float r) { m_r = r; }
+    float measurementNoise() const { return m_r; }
+    // Innovation, in standard deviations, above which a pixel is re-seeded.
+    void setResetThreshold(float sigmas) { m_gate = sigmas; }
+    float resetThreshold() const { return m_gate; }
+
+    // Drops all temporal state; the next frame is passed through unchanged.
+    void reset();
+
+    // Filters one frame of width * height depth samples into 'filtered'.
+    // 'depth' and 'filtered' may point to the same buffer. A change of
+    // resolution resets the filter.
+    void process(const float *depth, float *filtered, int width, int height);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    int frameCount() const { return m_frames; }
+    // Bytes held by the per-pixel state planes.
+    std::size_t stateBytes() const;
+    // Wall-clock cost of the most recent process() call.
+    long long lastFrameNanoseconds() const { return m_lastFrameNs; }
+    // Number of pixels re-seeded by the most recent process() call.
+    int lastResetCount() const { return m_lastResets; }
+
+private:
+    void seed(const float *depth, float *filtered, int count);
+    void update(const float *depth, float *filtered, int count);
+
+    std::vector<float> m_estimate;
+    std::vector<float> m_variance;
+    int m_width;
+    int m_height;
+    int m_frames;
+    float m_q;
+    float m_r;
+    float m_gate;
+    long long m_lastFrameNs;
+    int m_lastResets;
+};
+
+#endif // DEPTHFILTER_H
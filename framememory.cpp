@@ -0,0 +1,168 @@
+#include "framememory.h"
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+static const std::size_t minimumBlockSize = 64 * 1024;
+
+static char *heapAllocate(std::size_t size, AllocatorStats &stats)
+{
+    char *data = static_cast<char *>(::operator new(size));
+    stats.bytesReserved += size;
+    stats.peakBytesReserved = std::max(stats.peakBytesReserved, stats.bytesReserved);
+    ++stats.heapAllocations;
+    ++stats.heapAllocationsThisFrame;
+    return data;
+}
+
+static void heapFree(char *data, std::size_t size, AllocatorStats &stats)
+{
+    ::operator delete(data);
+    stats.bytesReserved -= size;
+}
+
+FrameArena::FrameArena(std::size_t initialCapacity)
+    : m_offset(0),
+      m_frameAlignment(1)
+{
+    if (initialCapacity > 0)
+        addBlock(initialCapacity);
+}
+
+FrameArena::~FrameArena()
+{
+    release();
+}
+
+void FrameArena::addBlock(std::size_t size)
+{
+    m_blocks.push_back({ heapAllocate(size, m_stats), size });
+    m_offset = 0;
+}
+
+void *FrameArena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    std::size_t padding = 0;
+    if (!m_blocks.empty()) {
+        const Block &block = m_blocks.back();
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block.data) + m_offset;
+        padding = (alignment - address % alignment) % alignment;
+        if (m_offset + padding + bytes > block.size) {
+            addBlock(std::max({ bytes + alignment, block.size * 2, minimumBlockSize }));
+            padding = (alignment - reinterpret_cast<std::uintptr_t>(m_blocks.back().data) % alignment) % alignment;
+        }
+    } else {
+        addBlock(std::max(bytes + alignment, minimumBlockSize));
+        padding = (alignment - reinterpret_cast<std::uintptr_t>(m_blocks.back().data) % alignment) % alignment;
+    }
+
+    char *p = m_blocks.back().data + m_offset + padding;
+    m_offset += padding + bytes;
+
+    m_stats.bytesInUse += padding + bytes;
+    m_stats.peakBytesInUse = std::max(m_stats.peakBytesInUse, m_stats.bytesInUse);
+    ++m_stats.allocationsThisFrame;
+    m_frameAlignment = std::max(m_frameAlignment, alignment);
+    return p;
+}
+
+void FrameArena::reset()
+{
+    // What the ending frame actually used, plus room for every allocation
+    // to need worst-case padding again in a fresh block.
+    const std::size_t needed = m_stats.bytesInUse
+            + std::size_t(m_stats.allocationsThisFrame) * (m_frameAlignment - 1);
+
+    m_offset = 0;
+    m_frameAlignment = 1;
+    m_stats.bytesInUse = 0;
+    m_stats.allocationsThisFrame = 0;
+    m_stats.heapAllocationsThisFrame = 0;
+
+    // Merge the blocks of an overflowing frame into one sized for that
+    // frame; the merge is charged to the frame that starts here.
+    if (m_blocks.size() > 1) {
+        for (const Block &block : m_blocks)
+            heapFree(block.data, block.size, m_stats);
+        m_blocks.clear();
+        addBlock(std::max(needed, minimumBlockSize));
+    }
+}
+
+void FrameArena::release()
+{
+    for (const Block &block : m_blocks)
+        heapFree(block.data, block.size, m_stats);
+    m_blocks.clear();
+    m_blocks.shrink_to_fit();
+    m_offset = 0;
+    m_frameAlignment = 1;
+    m_stats.bytesInUse = 0;
+}
+
+BufferPool::BufferPool()
+{
+}
+
+BufferPool::~BufferPool()
+{
+    for (const Buffer &buffer : m_buffers) {
+        assert(!buffer.inUse);
+        heapFree(buffer.data, buffer.size, m_stats);
+    }
+}
+
+void *BufferPool::acquire(std::size_t bytes)
+{
+    ++m_stats.allocationsThisFrame;
+
+    Buffer *best = nullptr;
+    for (Buffer &buffer : m_buffers) {
+        if (!buffer.inUse && buffer.size >= bytes && (!best || buffer.size < best->size))
+            best = &buffer;
+    }
+    if (!best) {
+        m_buffers.push_back({ heapAllocate(bytes, m_stats), bytes, false });
+        best = &m_buffers.back();
+    }
+
+    best->inUse = true;
+    m_stats.bytesInUse += best->size;
+    m_stats.peakBytesInUse = std::max(m_stats.peakBytesInUse, m_stats.bytesInUse);
+    return best->data;
+}
+
+void BufferPool::release(void *data)
+{
+    if (!data)
+        return;
+
+    for (Buffer &buffer : m_buffers) {
+        if (buffer.data == data) {
+            assert(buffer.inUse);
+            buffer.inUse = false;
+            m_stats.bytesInUse -= buffer.size;
+            return;
+        }
+    }
+    assert(!"BufferPool::release: buffer not owned by this pool");
+}
+
+void BufferPool::beginFrame()
+{
+    m_stats.allocationsThisFrame = 0;
+    m_stats.heapAllocationsThisFrame = 0;
+}
+
+void BufferPool::trim()
+{
+    auto it = std::remove_if(m_buffers.begin(), m_buffers.end(), [this](const Buffer &buffer) {
+        if (buffer.inUse)
+            return false;
+        heapFree(buffer.data, buffer.size, m_stats);
+        return true;
+    });
+    m_buffers.erase(it, m_buffers.end());
+}
@@ -0,0 +1,101 @@
+#ifndef FRAMEMEMORY_H
+#define FRAMEMEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Counters shared by FrameArena and BufferPool. "Reserved" is memory taken
+// from the heap (what the allocator adds to RSS), "in use" is what callers
+// currently hold. The per-frame counters restart at FrameArena::reset() /
+// BufferPool::beginFrame().
+struct AllocatorStats
+{
+    std::size_t bytesReserved = 0;
+    std::size_t peakBytesReserved = 0;
+    std::size_t bytesInUse = 0;
+    std::size_t peakBytesInUse = 0;
+    std::uint64_t heapAllocations = 0;
+    int allocationsThisFrame = 0;
+    int heapAllocationsThisFrame = 0;
+};
+
+// Bump allocator for buffers that live at most one frame (decode scratch,
+// filtered depth, vertex staging). allocate() is a pointer increment;
+// nothing is freed individually. reset() rewinds the arena for the next
+// frame. If a frame overflowed into extra blocks, they are replaced by one
+// block sized to what that frame used (counted as a heap allocation of the
+// next frame), so a steady-state frame does no heap allocation at all.
+class FrameArena
+{
+public:
+    explicit FrameArena(std::size_t initialCapacity = 0);
+    ~FrameArena();
+
+    void *allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+    template <typename T>
+    T *allocate(std::size_t count) { return static_cast<T *>(allocate(count * sizeof(T), alignof(T))); }
+
+    // Invalidates everything allocated since the previous reset().
+    void reset();
+    // Returns all memory to the heap.
+    void release();
+
+    const AllocatorStats &stats() const { return m_stats; }
+
+private:
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    struct Block
+    {
+        char *data;
+        std::size_t size;
+    };
+
+    void addBlock(std::size_t size);
+
+    std::vector<Block> m_blocks;
+    std::size_t m_offset;
+    std::size_t m_frameAlignment;  // Largest alignment requested this frame
+    AllocatorStats m_stats;
+};
+
+// Keeps frame-sized buffers that are needed every frame (depth frames,
+// filter outputs) alive between frames. acquire() hands out the smallest
+// free buffer that fits and only touches the heap when none does; release()
+// puts a buffer back for the next acquire().
+class BufferPool
+{
+public:
+    BufferPool();
+    ~BufferPool();
+
+    void *acquire(std::size_t bytes);
+    template <typename T>
+    T *acquire(std::size_t count) { return static_cast<T *>(acquire(count * sizeof(T))); }
+    void release(void *buffer);
+
+    // Starts a new frame for the per-frame counters.
+    void beginFrame();
+    // Frees every buffer that is not currently acquired.
+    void trim();
+
+    const AllocatorStats &stats() const { return m_stats; }
+
+private:
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    struct Buffer
+    {
+        char *data;
+        std::size_t size;
+        bool inUse;
+    };
+
+    std::vector<Buffer> m_buffers;
+    AllocatorStats m_stats;
+};
+
+#endif // FRAMEMEMORY_H
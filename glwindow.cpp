@@ -6,6 +6,10 @@
 #include <QOpenGLContext>
 #include <QOpenGLVertexArrayObject>
 #include <QOpenGLExtraFunctions>
+#if !QT_CONFIG(opengles2)
+#include <QOpenGLTimerQuery>
+#endif
+#include <QCoreApplication>
 #include <QPropertyAnimation>
 #include <QPauseAnimation>
 #include <QSequentialAnimationGroup>
@@ -27,9 +31,6 @@ float depth_map[10][10] = {
     {0.31233507, 0.32947558, 0.6116558,  0.7482836,  0.21618518, 0.59165317, 0.08508845, 0.6554845,  0.59711534, 0.0649782}
     };
 
-std::vector<GLfloat> vertices;
-
-
 GLWindow::GLWindow()
     : m_texture(0),
       m_program(0),
@@ -38,8 +39,16 @@ GLWindow::GLWindow()
       m_target(0, 0, -1),
       m_uniformsDirty(true),
       m_r(0),
-      m_r2(0)
+      m_r2(0),
+      m_vertexCount(0)
 {
+#if !QT_CONFIG(opengles2)
+    for (int i = 0; i < TimerQueryCount; ++i) {
+        m_timerQueries[i] = 0;
+        m_timerQueryFrame[i] = -1;
+    }
+#endif
+
     m_world.setToIdentity();
     m_world.translate(0, 0, -1);
     m_world.rotate(180, 1, 0, 0);
@@ -88,24 +97,118 @@ GLWindow::GLWindow()
     rAnim->start();*/
 }
 
+void GLWindow::startBenchmark(const CameraPath &path, int frames, int warmupFrames, const QString &reportFileName)
+{
+    m_benchmarkPath = path;
+    m_benchmarkFrames = frames;
+    m_benchmarkFrame = 0;
+    m_warmupFrames = warmupFrames;
+    m_reportFileName = reportFileName;
+    m_report.clear();
+    m_report.reserve(frames);  // No report growth while frames are timed
+    m_report.setInfo(QStringLiteral("cameraPath"), path.fileName());
+    m_report.setInfo(QStringLiteral("frames"), QString::number(frames));
+    m_report.setInfo(QStringLiteral("warmupFrames"), QString::number(warmupFrames));
+    update();
+}
+
+void GLWindow::startRecording(const QString &fileName)
+{
+    m_recordFileName = fileName;
+    m_recordedPath.clear();
+}
+
+double GLWindow::recordTime()
+{
+    if (!m_recordClock.isValid())
+        m_recordClock.start();
+    return m_recordClock.nsecsElapsed() / 1e6;
+}
+
+void GLWindow::recordKeyframe(double time)
+{
+    if (m_recordFileName.isEmpty() || isBenchmarking())
+        return;
+
+    CameraKeyframe k;
+    k.time = time;
+    k.eye = m_eye;
+    k.yaw = m_yaw;
+    k.pitch = m_pitch;
+    m_recordedPath.addKeyframe(k);
+}
+
+void GLWindow::applyCameraPath()
+{
+    // Spread the frames evenly over the path so a run is independent of
+    // how fast the frames are actually produced.
+    const double t = m_benchmarkPath.startTime() + (m_benchmarkFrames > 1
+            ? m_benchmarkPath.duration() * m_benchmarkFrame / (m_benchmarkFrames - 1)
+            : 0.0);
+    const CameraKeyframe k = m_benchmarkPath.sample(t);
+    m_eye = k.eye;
+    m_yaw = k.yaw;
+    m_pitch = k.pitch;
+    m_uniformsDirty = true;
+}
+
+#if !QT_CONFIG(opengles2)
+void GLWindow::collectTimerQuery(int slot)
+{
+    if (m_timerQueryFrame[slot] < 0)
+        return;
+    m_report.setGpuTime(m_timerQueryFrame[slot], m_timerQueries[slot]->waitForResult() / 1e6);
+    m_timerQueryFrame[slot] = -1;
+}
+#endif
+
+void GLWindow::finishBenchmark()
+{
+    m_benchmarkFrames = 0;
+
+#if !QT_CONFIG(opengles2)
+    for (int i = 0; i < TimerQueryCount; ++i)
+        collectTimerQuery(i);
+#endif
+    m_report.setInfo(QStringLiteral("windowSize"), QStringLiteral("%1x%2").arg(width()).arg(height()));
+
+    m_report.setInfo(QStringLiteral("arenaPeakBytes"), QString::number(m_frameArena.stats().peakBytesReserved));
+    m_report.setInfo(QStringLiteral("poolPeakBytes"), QString::number(m_bufferPool.stats().peakBytesReserved));
+
+    QString error;
+    if (m_report.save(m_reportFileName, &error))
+        std::cout << "Benchmark report written to " << qPrintable(m_reportFileName) << std::endl;
+    else
+        std::cerr << "Cannot write " << qPrintable(m_reportFileName) << ": " << qPrintable(error) << std::endl;
+
+    QTimer::singleShot(0, qApp, &QCoreApplication::quit);
+}
+
 void GLWindow::mousePressEvent(QMouseEvent *event)
 {
+    if (isBenchmarking())
+        return;
     m_lastMousePosition = event->pos();
     m_mousePressed = true;
 }
 
 void GLWindow::mouseMoveEvent(QMouseEvent *event)
 {
-    if (m_mousePressed)
+    if (m_mousePressed && !isBenchmarking())
     {
         int dx = event->x() - m_lastMousePosition.x();
         int dy = event->y() - m_lastMousePosition.y();
 
+        // Record the pose on both sides of the change so it replays as a step.
+        const double time = recordTime();
+        recordKeyframe(time);
+
         m_yaw += dx * 0.5f;  // Adjust the sensitivity as needed
         m_pitch += dy * 0.5f;
 
         m_lastMousePosition = event->pos();
 
+        recordKeyframe(time);
         m_uniformsDirty = true;
         update();  // Trigger a redraw
     }
@@ -118,45 +221,73 @@ void GLWindow::mouseReleaseEvent(QMouseEvent *event)
 
 void GLWindow::keyPressEvent(QKeyEvent *event)
 {
+    if (isBenchmarking())
+        return;
+
     float step = 5.0;//0.5f;  // Adjust this step value as needed
+    QVector3D eye = m_eye;
 
     switch (event->key()) {
     case Qt::Key_W:
-        m_eye.setY(m_eye.y() - step);   // Move up
+        eye.setY(eye.y() - step);   // Move up
         break;
     case Qt::Key_S:
-        m_eye.setY(m_eye.y() + step);   // Move down
+        eye.setY(eye.y() + step);   // Move down
         break;
     case Qt::Key_A:
-        m_eye.setX(m_eye.x() + step);  // Pan left
+        eye.setX(eye.x() + step);  // Pan left
         break;
     case Qt::Key_D:
-        m_eye.setX(m_eye.x() - step);  // Pan right
+        eye.setX(eye.x() - step);  // Pan right
         break;
     default:
         QOpenGLWindow::keyPressEvent(event);  // Call the base class implementation for other keys
+        return;
     }
 
+    // Record the pose on both sides of the change so it replays as a step.
+    const double time = recordTime();
+    recordKeyframe(time);
+    m_eye = eye;
+    recordKeyframe(time);
+
     m_uniformsDirty = true;
     update();  // Trigger a redraw to reflect the camera changes
 }
 
 void GLWindow::wheelEvent(QWheelEvent *event)
 {
+    if (isBenchmarking())
+        return;
+
+    const double time = recordTime();
+    recordKeyframe(time);
+
     float delta = event->angleDelta().y() / 120.0f;  // 120 is the typical delta value for one notch of the wheel
     m_eye.setZ(m_eye.z() - 10 * delta);  // Zoom in or out based on wheel movement
 
+    recordKeyframe(time);
     m_uniformsDirty = true;
     update();  // Trigger a redraw
 }
 
 GLWindow::~GLWindow()
 {
+    if (!m_recordFileName.isEmpty()) {
+        QString error;
+        if (!m_recordedPath.save(m_recordFileName, &error))
+            std::cerr << "Cannot write " << qPrintable(m_recordFileName) << ": " << qPrintable(error) << std::endl;
+    }
+
     makeCurrent();
     delete m_texture;
     delete m_program;
     delete m_vbo;
     delete m_vao;
+#if !QT_CONFIG(opengles2)
+    for (int i = 0; i < TimerQueryCount; ++i)
+        delete m_timerQueries[i];
+#endif
 }
 
 void GLWindow::startSecondStage()
@@ -290,6 +421,17 @@ void GLWindow::initializeGL()
     std::cout << "depthMap.cols = " << depthMap.cols << std::endl;
     std::cout << "depthMap.rows = " << depthMap.rows << std::endl;
 
+    // CPU-side buffers only live until the upload below: the depth
+    // frame comes from the pool, the vertex staging from the frame arena.
+    m_frameArena.reset();
+    m_bufferPool.beginFrame();
+    const int pixelCount = depthMap.cols * depthMap.rows;
+    float *depth = m_bufferPool.acquire<float>(pixelCount);
+
+    for (int y = 0; y < depthMap.rows; ++y)
+        for (int x = 0; x < depthMap.cols; ++x)
+            depth[y * depthMap.cols + x] = depthMap.at<float>(y, x);
+
     float centerX = (depthMap.cols - 1) / 2.0f;
     float centerY = (depthMap.rows - 1) / 2.0f;
     float centerZ = 0.0f;  // Assuming flat ground, or you can calculate the average depth.
@@ -297,17 +439,20 @@ void GLWindow::initializeGL()
     float scaleFactor = 1.0f;  // Adjust this factor based on your depth map values
     float depthMult = 1.0f;
 
+    const int floatCount = pixelCount * 3;
+    GLfloat *vertices = m_frameArena.allocate<GLfloat>(floatCount);
+    GLfloat *v = vertices;
     for (int y = 0; y < depthMap.rows; ++y) {
         for (int x = 0; x < depthMap.cols; ++x) {
-            float z = depthMap.at<float>(y, x);  // z-coordinate from the depth map
-            vertices.push_back(static_cast<float>(x) * scaleFactor);  // x-coordinate
-            vertices.push_back(static_cast<float>(y) * scaleFactor);  // y-coordinate
-            vertices.push_back(z * depthMult);  // z-coordinate from the depth map
+            float z = depth[y * depthMap.cols + x];  // z-coordinate from the depth map
+            *v++ = static_cast<float>(x) * scaleFactor;  // x-coordinate
+            *v++ = static_cast<float>(y) * scaleFactor;  // y-coordinate
+            *v++ = z * depthMult;  // z-coordinate from the depth map
 
             // Normal vector - set to a default value if not calculated
-            /*vertices.push_back(0.0f);  // nx
-            vertices.push_back(0.0f);  // ny
-            vertices.push_back(1.0f);  // nz*/
+            /* *v++ = 0.0f;  // nx
+            *v++ = 0.0f;  // ny
+            *v++ = 1.0f;  // nz*/
         }
     }
 
@@ -315,8 +460,19 @@ void GLWindow::initializeGL()
     QVector2D centeredTranslation(-centerX, -centerY);  // Center the image
     m_program->setUniformValue(translation, centeredTranslation);    
 
-    //m_vbo->allocate(m_logo.constData(), m_logo.count() * sizeof(GLfloat));
-    m_vbo->allocate(vertices.data(), vertices.size() * sizeof(GLfloat));
+    m_vbo->allocate(vertices, floatCount * sizeof(GLfloat));
+    m_vertexCount = floatCount / 6;
+
+    // The GPU has its own copy now; drop the CPU ones.
+    m_bufferPool.release(depth);
+    m_bufferPool.trim();
+    m_frameArena.release();
+    std::cout << "staging peak = " << m_frameArena.stats().peakBytesReserved << " bytes arena, "
+              << m_bufferPool.stats().peakBytesReserved << " bytes pool" << std::endl;
+    std::cout << "staging allocations = " << m_frameArena.stats().allocationsThisFrame << " arena ("
+              << m_frameArena.stats().heapAllocationsThisFrame << " from heap), "
+              << m_bufferPool.stats().allocationsThisFrame << " pool ("
+              << m_bufferPool.stats().heapAllocationsThisFrame << " from heap)" << std::endl;
     f->glEnableVertexAttribArray(0);
     f->glEnableVertexAttribArray(1);
     f->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), 0);
@@ -327,6 +483,33 @@ void GLWindow::initializeGL()
 
     f->glEnable(GL_DEPTH_TEST);
     f->glEnable(GL_CULL_FACE);
+
+#if !QT_CONFIG(opengles2)
+    // GPU frame times need timer queries, which OpenGL ES 3.0 does not have.
+    bool timerQueries = !QOpenGLContext::currentContext()->isOpenGLES();
+    for (int i = 0; i < TimerQueryCount; ++i) {
+        delete m_timerQueries[i];
+        m_timerQueries[i] = 0;
+        m_timerQueryFrame[i] = -1;
+        if (timerQueries) {
+            m_timerQueries[i] = new QOpenGLTimerQuery;
+            timerQueries = m_timerQueries[i]->create();
+        }
+    }
+    if (!timerQueries) {
+        for (int i = 0; i < TimerQueryCount; ++i) {
+            delete m_timerQueries[i];
+            m_timerQueries[i] = 0;
+        }
+    }
+#endif
+
+    m_report.setInfo(QStringLiteral("renderer"),
+                     QString::fromLatin1(reinterpret_cast<const char *>(f->glGetString(GL_RENDERER))));
+
+    // Start the recording from the initial camera pose.
+    if (!m_recordFileName.isEmpty() && m_recordedPath.isEmpty())
+        recordKeyframe(recordTime());
 }
 
 void GLWindow::resizeGL(int w, int h)
@@ -341,6 +524,31 @@ void GLWindow::paintGL()
 {
     QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
 
+    // Warm-up frames render the first pose untimed, so one-off first-draw
+    // driver work does not end up in the report.
+    const bool benchmarking = isBenchmarking();
+    const bool timed = benchmarking && m_warmupFrames == 0;
+#if !QT_CONFIG(opengles2)
+    const int timerSlot = m_benchmarkFrame % TimerQueryCount;
+    QOpenGLTimerQuery *timerQuery = timed ? m_timerQueries[timerSlot] : 0;
+#endif
+    QElapsedTimer cpuTimer;
+    if (benchmarking)
+        applyCameraPath();
+    if (timed) {
+#if !QT_CONFIG(opengles2)
+        // This slot last measured a frame TimerQueryCount frames ago, which
+        // the GPU has long finished, so reading it back does not stall.
+        if (timerQuery)
+            collectTimerQuery(timerSlot);
+#endif
+        cpuTimer.start();
+#if !QT_CONFIG(opengles2)
+        if (timerQuery)
+            timerQuery->begin();
+#endif
+    }
+
     f->glClearColor(0, 0, 0, 1);
     f->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -362,5 +570,28 @@ void GLWindow::paintGL()
         m_program->setUniformValue(m_worldMatrixLoc, wm);
     }
 
-    f->glDrawArrays(GL_POINTS, 0, vertices.size() / 6);
+    f->glDrawArrays(GL_POINTS, 0, m_vertexCount);
+
+    if (timed) {
+        FrameSample sample;
+        sample.cpuMs = cpuTimer.nsecsElapsed() / 1e6;
+        sample.vertices = m_vertexCount;
+        m_report.addFrame(sample);
+#if !QT_CONFIG(opengles2)
+        if (timerQuery) {
+            timerQuery->end();
+            m_timerQueryFrame[timerSlot] = m_benchmarkFrame;
+        }
+#endif
+
+        if (++m_benchmarkFrame >= m_benchmarkFrames) {
+            finishBenchmark();
+            return;
+        }
+    } else if (benchmarking) {
+        --m_warmupFrames;
+    }
+
+    if (benchmarking)
+        update();  // Keep frames coming without waiting for input
 }
@@ -6,7 +6,10 @@
 #include <QWheelEvent>
 #include <QMatrix4x4>
 #include <QVector3D>
-#include "../hellogl2/logo.h"
+#include <QElapsedTimer>
+#include "camerapath.h"
+#include "benchmark.h"
+#include "framememory.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -14,6 +17,9 @@ class QOpenGLTexture;
 class QOpenGLShaderProgram;
 class QOpenGLBuffer;
 class QOpenGLVertexArrayObject;
+#if !QT_CONFIG(opengles2)
+class QOpenGLTimerQuery;
+#endif
 
 QT_END_NAMESPACE
 
@@ -39,6 +45,15 @@ public:
     void setR(float v);
     float r2() const { return m_r2; }
     void setR2(float v);
+
+    // Renders 'warmupFrames' untimed frames, then replays 'path' for exactly
+    // 'frames' timed frames, ignoring live input. Writes a BenchmarkReport
+    // to 'reportFileName' and quits the application.
+    void startBenchmark(const CameraPath &path, int frames, int warmupFrames, const QString &reportFileName);
+    // Records the live camera into a CameraPath that is saved to 'fileName'
+    // when the window is destroyed.
+    void startRecording(const QString &fileName);
+
 private slots:
     void startSecondStage();
 
@@ -51,11 +66,19 @@ protected:
     void keyPressEvent(QKeyEvent *event) override;
     
 private:
+    bool isBenchmarking() const { return m_benchmarkFrames > 0; }
+    void applyCameraPath();
+#if !QT_CONFIG(opengles2)
+    void collectTimerQuery(int slot);
+#endif
+    void finishBenchmark();
+    double recordTime();
+    void recordKeyframe(double time);
+
     QOpenGLTexture *m_texture;
     QOpenGLShaderProgram *m_program;
     QOpenGLBuffer *m_vbo;
     QOpenGLVertexArrayObject *m_vao;
-    Logo m_logo;
     int m_projMatrixLoc;
     int m_camMatrixLoc;
     int m_worldMatrixLoc;
@@ -68,11 +91,32 @@ private:
     bool m_uniformsDirty;
     float m_r;
     float m_r2;
+    int m_vertexCount;
+    FrameArena m_frameArena;
+    BufferPool m_bufferPool;
 
     QPoint m_lastMousePosition;
     float m_yaw = 0.0f;  // Rotation around the y-axis
     float m_pitch = 0.0f;  // Rotation around the x-axis
     bool m_mousePressed;
+
+#if !QT_CONFIG(opengles2)
+    // GPU times are read back TimerQueryCount frames late so that the CPU
+    // never waits on the GPU in the middle of a run.
+    enum { TimerQueryCount = 3 };
+    QOpenGLTimerQuery *m_timerQueries[TimerQueryCount];
+    int m_timerQueryFrame[TimerQueryCount];  // Frame each query measures, -1 if none
+#endif
+    CameraPath m_benchmarkPath;
+    BenchmarkReport m_report;
+    QString m_reportFileName;
+    int m_benchmarkFrames = 0;
+    int m_benchmarkFrame = 0;
+    int m_warmupFrames = 0;
+
+    CameraPath m_recordedPath;
+    QString m_recordFileName;
+    QElapsedTimer m_recordClock;
 };
 
 #endif
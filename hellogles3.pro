@@ -1,9 +1,15 @@
 HEADERS = $$PWD/glwindow.h \
-          $$PWD/../hellogl2/logo.h
+          $$PWD/depthfilter.h \
+          $$PWD/camerapath.h \
+          $$PWD/benchmark.h \
+          $$PWD/framememory.h
 
 SOURCES = $$PWD/glwindow.cpp \
-          $$PWD/main.cpp \
-          $$PWD/../hellogl2/logo.cpp
+          $$PWD/depthfilter.cpp \
+          $$PWD/camerapath.cpp \
+          $$PWD/benchmark.cpp \
+          $$PWD/framememory.cpp \
+          $$PWD/main.cpp
 
 RESOURCES += hellogles3.qrc
 
@@ -51,6 +51,8 @@
 #include <QGuiApplication>
 #include <QSurfaceFormat>
 #include <QOpenGLContext>
+#include <QCommandLineParser>
+#include <iostream>
 
 #include "glwindow.h"
 
@@ -62,10 +64,68 @@
 // creation has to have a sufficiently high version number for the features that are in
 // use, and (2) the shader code's version directive is different.
 
+// Benchmarking:
+//   hellogles3 --camera-path path.json [--frames N] [--warmup N] [--report out.json]
+//       replays a camera path for N frames and writes per-frame timings.
+//   hellogles3 --record path.json
+//       records the live camera into a path file on exit.
+//   hellogles3 --compare baseline.json current.json [--threshold PERCENT]
+//       compares two reports; exits with 1 if any metric regressed.
+// Any QPA platform works, e.g. add "-platform offscreen" for headless runs.
+
+static int compareReports(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addOption({ "compare", "Compare two benchmark reports." });
+    parser.addOption({ "threshold", "Allowed slowdown in percent (default 5).", "percent", "5" });
+    parser.addPositionalArgument("baseline", "Baseline report.");
+    parser.addPositionalArgument("current", "Report to check.");
+    parser.process(app);
+
+    const QStringList files = parser.positionalArguments();
+    if (files.size() != 2)
+        parser.showHelp(2);
+
+    const int regressions = compareBenchmarkReports(files.at(0), files.at(1),
+                                                    parser.value("threshold").toDouble());
+    if (regressions < 0)
+        return 2;
+    std::cout << regressions << " regression(s)" << std::endl;
+    return regressions > 0 ? 1 : 0;
+}
+
 int main(int argc, char *argv[])
 {
+    // Comparing reports needs no window system, so keep it off QGuiApplication.
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--compare") == 0)
+            return compareReports(argc, argv);
+    }
+
     QGuiApplication app(argc, argv);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOption({ "camera-path", "Replay a camera path and benchmark it.", "file" });
+    parser.addOption({ "frames", "Number of frames to replay (default 600).", "count", "600" });
+    parser.addOption({ "warmup", "Untimed frames before the replay (default 10).", "count", "10" });
+    parser.addOption({ "report", "Benchmark report file (default benchmark.json).", "file", "benchmark.json" });
+    parser.addOption({ "record", "Record the live camera into a path file.", "file" });
+    parser.process(app);
+
+    CameraPath path;
+    if (parser.isSet("camera-path")) {
+        QString error;
+        if (!path.load(parser.value("camera-path"), &error)) {
+            std::cerr << "Cannot load " << qPrintable(parser.value("camera-path")) << ": "
+                      << qPrintable(error) << std::endl;
+            return 2;
+        }
+    }
+    const bool benchmark = !path.isEmpty();
+
     QSurfaceFormat fmt;
     fmt.setDepthBufferSize(24);
 
@@ -79,10 +139,24 @@ int main(int argc, char *argv[])
         fmt.setVersion(3, 0);
     }
 
+    // Do not let vsync cap the measured frame rate.
+    if (benchmark)
+        fmt.setSwapInterval(0);
+
     QSurfaceFormat::setDefaultFormat(fmt);
 
     GLWindow glWindow;
-    glWindow.showMaximized();
+    if (parser.isSet("record"))
+        glWindow.startRecording(parser.value("record"));
+    if (benchmark) {
+        glWindow.startBenchmark(path, qMax(1, parser.value("frames").toInt()),
+                                qMax(0, parser.value("warmup").toInt()), parser.value("report"));
+        // A fixed size keeps runs comparable across machines and screens.
+        glWindow.resize(1280, 720);
+        glWindow.show();
+    } else {
+        glWindow.showMaximized();
+    }
 
     return app.exec();
 }
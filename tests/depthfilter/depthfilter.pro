@@ -0,0 +1,12 @@
+TEMPLATE = app
+TARGET = tst_depthfilter
+QT = core testlib
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../..
+
+HEADERS = $$PWD/../../depthfilter.h
+
+SOURCES = $$PWD/tst_depthfilter.cpp \
+          $$PWD/../../depthfilter.cpp
@@ -0,0 +1,176 @@
+#include <QtTest>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "depthfilter.h"
+
+class tst_DepthFilter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void staticNoiseIsReduced();
+    void movingEdgeIsNotSmeared();
+    void missingSamplesPassThrough();
+    void simdMatchesScalar();
+};
+
+// Synthetic scene: a few depth planes (1.0 m .. 3.0 m) in vertical stripes.
+static float groundTruth(int x)
+{
+    return 1.0f + (x % 5) * 0.5f;
+}
+
+// A static scene seen through Gaussian sensor noise; the filtered output
+// must sit much closer to the truth than the raw samples.
+void tst_DepthFilter::staticNoiseIsReduced()
+{
+    const int width = 64;
+    const int height = 48;
+    const int count = width * height;
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.0f, 0.03f);
+
+    DepthFilter filter;
+    std::vector<float> depth(count);
+    std::vector<float> filtered(count);
+    double rawError = 0.0;
+    double filteredError = 0.0;
+
+    for (int frame = 0; frame < 100; ++frame) {
+        for (int i = 0; i < count; ++i)
+            depth[i] = groundTruth(i % width) + noise(rng);
+        filter.process(depth.data(), filtered.data(), width, height);
+
+        if (frame < 20)
+            continue;  // let the estimate converge
+        for (int i = 0; i < count; ++i) {
+            const double truth = groundTruth(i % width);
+            rawError += (depth[i] - truth) * (depth[i] - truth);
+            filteredError += (filtered[i] - truth) * (filtered[i] - truth);
+        }
+    }
+
+    qDebug("variance %g -> %g (%.1fx), %zu bytes state, %lld ns per update",
+           rawError / (80.0 * count), filteredError / (80.0 * count), rawError / filteredError,
+           filter.stateBytes(), filter.lastFrameNanoseconds());
+    QVERIFY(filteredError * 4.0 < rawError);
+    QCOMPARE(filter.stateBytes(), std::size_t(2 * count) * sizeof(float));
+    QCOMPARE(filter.frameCount(), 100);
+}
+
+// An object sweeping across a static background: every pixel it covers
+// must show the new depth on the very first frame, not a blend.
+void tst_DepthFilter::movingEdgeIsNotSmeared()
+{
+    const int width = 64;
+    const int height = 8;
+    const int count = width * height;
+    std::mt19937 rng(2);
+    std::normal_distribution<float> noise(0.0f, 0.03f);
+
+    DepthFilter filter;
+    std::vector<float> depth(count);
+    std::vector<float> filtered(count);
+
+    for (int frame = 0; frame < 60; ++frame) {
+        const int edge = frame < 20 ? 0 : frame - 20;  // object covers x < edge
+        for (int i = 0; i < count; ++i) {
+            const int x = i % width;
+            depth[i] = groundTruth(x) + (x < edge ? 2.0f : 0.0f) + noise(rng);
+        }
+        filter.process(depth.data(), filtered.data(), width, height);
+
+        if (frame == 0)
+            QCOMPARE(filter.lastResetCount(), count);
+        else if (frame > 20)
+            QVERIFY(filter.lastResetCount() >= height);
+
+        int stale = 0;
+        for (int i = 0; i < count; ++i) {
+            const int x = i % width;
+            const float truth = groundTruth(x) + (x < edge ? 2.0f : 0.0f);
+            if (std::fabs(filtered[i] - truth) > 0.2f)
+                ++stale;
+        }
+        QCOMPARE(stale, 0);
+    }
+}
+
+// Missing samples must never turn into fake depth.
+void tst_DepthFilter::missingSamplesPassThrough()
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    const int count = 9;  // covers SIMD lanes and the scalar tail
+    const float missing[count] = { nan, 0.0f, -1.0f, inf, nan, 0.0f, -1.0f, inf, nan };
+
+    DepthFilter filter;
+    float depth[count];
+    float filtered[count];
+    std::memcpy(depth, missing, sizeof(depth));
+
+    // No estimate yet: every sample is passed through unchanged.
+    for (int frame = 0; frame < 2; ++frame) {
+        filter.process(depth, filtered, count, 1);
+        QCOMPARE(filter.lastResetCount(), 0);
+        for (int i = 0; i < count; ++i) {
+            if (std::isnan(depth[i]))
+                QVERIFY(std::isnan(filtered[i]));
+            else
+                QCOMPARE(filtered[i], depth[i]);
+        }
+    }
+
+    // Once a pixel has an estimate, a missing sample keeps it.
+    for (int i = 0; i < count; ++i)
+        depth[i] = 2.0f;
+    filter.process(depth, filtered, count, 1);
+    QCOMPARE(filter.lastResetCount(), count);
+    std::memcpy(depth, missing, sizeof(depth));
+    filter.process(depth, filtered, count, 1);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(filtered[i], 2.0f);
+}
+
+// Pixels 0..3 go through the SIMD body and 4..6 through the scalar tail.
+// Feeding pixel i and i + 4 the same history must give identical bits.
+void tst_DepthFilter::simdMatchesScalar()
+{
+    const int width = 7;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::uniform_int_distribution<int> event(0, 19);
+
+    DepthFilter filter;
+    float depth[width];
+    float filtered[width];
+    float base[3] = { 1.0f, 2.0f, 4.0f };
+
+    for (int frame = 0; frame < 500; ++frame) {
+        for (int i = 0; i < 3; ++i) {
+            const int e = event(rng);
+            if (e == 0)
+                base[i] += 1.5f;  // step
+            float z = base[i] + noise(rng);
+            if (e == 1)
+                z = nan;
+            else if (e == 2)
+                z = 0.0f;
+            depth[i] = depth[i + 4] = z;
+        }
+        depth[3] = 1.0f + noise(rng);
+        filter.process(depth, filtered, width, 1);
+
+        for (int i = 0; i < 3; ++i)
+            QVERIFY(std::memcmp(&filtered[i], &filtered[i + 4], sizeof(float)) == 0);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_DepthFilter)
+
+#include "tst_depthfilter.moc"
@@ -0,0 +1,12 @@
+TEMPLATE = app
+TARGET = tst_framememory
+QT = core testlib
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../..
+
+HEADERS = $$PWD/../../framememory.h
+
+SOURCES = $$PWD/tst_framememory.cpp \
+          $$PWD/../../framememory.cpp
@@ -0,0 +1,158 @@
+#include <QtTest>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "framememory.h"
+
+// Count every heap allocation in the process so the tests can check the
+// allocators' own statistics against what really happened.
+static long heapAllocations = 0;
+
+void *operator new(std::size_t size)
+{
+    ++heapAllocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+class tst_FrameMemory : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void steadyStateDoesNotAllocate();
+    void overflowingFrameIsMerged();
+    void poolPicksBestFit();
+};
+
+static const std::size_t depthFrameFloats = 784 * 448;
+
+// One frame of a per-frame path: a pooled depth frame plus arena scratch
+// for vertex staging and a few small, differently aligned buffers.
+// Returns false if an arena allocation came back misaligned.
+static bool runFrame(FrameArena &arena, BufferPool &pool)
+{
+    arena.reset();
+    pool.beginFrame();
+
+    float *depth = pool.acquire<float>(depthFrameFloats);
+    float *vertices = arena.allocate<float>(depthFrameFloats * 3);
+    double *scratch = arena.allocate<double>(16);
+    void *aligned = arena.allocate(100, 64);
+
+    std::memset(vertices, 0, depthFrameFloats * 3 * sizeof(float));
+    depth[0] = vertices[0];
+    pool.release(depth);
+
+    return reinterpret_cast<std::uintptr_t>(scratch) % alignof(double) == 0
+            && reinterpret_cast<std::uintptr_t>(aligned) % 64 == 0;
+}
+
+void tst_FrameMemory::steadyStateDoesNotAllocate()
+{
+    FrameArena arena;
+    BufferPool pool;
+
+    for (int frame = 0; frame < 10; ++frame) {
+        const long before = heapAllocations;
+        const bool aligned = runFrame(arena, pool);
+        const long made = heapAllocations - before;
+
+        QVERIFY(aligned);
+        QCOMPARE(arena.stats().allocationsThisFrame, 3);
+        QCOMPARE(pool.stats().allocationsThisFrame, 1);
+        if (frame >= 2) {
+            QCOMPARE(arena.stats().heapAllocationsThisFrame, 0);
+            QCOMPARE(pool.stats().heapAllocationsThisFrame, 0);
+            QCOMPARE(made, 0L);
+        }
+    }
+    QCOMPARE(pool.stats().bytesInUse, std::size_t(0));
+}
+
+// A frame that overflows the first block spills into more blocks; the next
+// reset() replaces them with one block sized to what the frame used and
+// charges that allocation to the new frame.
+void tst_FrameMemory::overflowingFrameIsMerged()
+{
+    const std::size_t chunk = 100 * 1024;
+    FrameArena arena(1024);
+    QCOMPARE(arena.stats().heapAllocations, std::uint64_t(1));
+
+    arena.reset();
+    for (int i = 0; i < 8; ++i)
+        arena.allocate(chunk);
+    const std::size_t used = arena.stats().bytesInUse;
+    QVERIFY(arena.stats().heapAllocationsThisFrame > 1);
+    QVERIFY(used >= 8 * chunk);
+
+    arena.reset();
+    QCOMPARE(arena.stats().heapAllocationsThisFrame, 1);
+    QCOMPARE(arena.stats().bytesInUse, std::size_t(0));
+    // Sized from the frame's use, not the sum of the doubling blocks.
+    QVERIFY(arena.stats().bytesReserved >= used);
+    QVERIFY(arena.stats().bytesReserved < used + 8 * alignof(std::max_align_t));
+
+    for (int i = 0; i < 8; ++i)
+        arena.allocate(chunk);
+    QCOMPARE(arena.stats().heapAllocationsThisFrame, 1);
+
+    arena.reset();
+    for (int i = 0; i < 8; ++i)
+        arena.allocate(chunk);
+    QCOMPARE(arena.stats().heapAllocationsThisFrame, 0);
+
+    arena.release();
+    QCOMPARE(arena.stats().bytesReserved, std::size_t(0));
+}
+
+// acquire() must hand out the smallest free buffer that fits.
+void tst_FrameMemory::poolPicksBestFit()
+{
+    BufferPool pool;
+    void *small = pool.acquire(100);
+    void *medium = pool.acquire(200);
+    void *large = pool.acquire(300);
+    QCOMPARE(pool.stats().heapAllocations, std::uint64_t(3));
+    QCOMPARE(pool.stats().bytesInUse, std::size_t(600));
+    pool.release(large);
+    pool.release(small);
+    pool.release(medium);
+    QCOMPARE(pool.stats().bytesInUse, std::size_t(0));
+
+    pool.beginFrame();
+    QCOMPARE(pool.acquire(150), medium);
+    QCOMPARE(pool.acquire(50), small);
+    QCOMPARE(pool.acquire(250), large);
+    QCOMPARE(pool.stats().heapAllocationsThisFrame, 0);
+
+    // Nothing free fits: a new buffer comes from the heap.
+    void *extra = pool.acquire(50);
+    QVERIFY(extra != small && extra != medium && extra != large);
+    QCOMPARE(pool.stats().heapAllocationsThisFrame, 1);
+
+    pool.release(small);
+    pool.release(medium);
+    pool.release(large);
+    pool.release(extra);
+    pool.trim();
+    QCOMPARE(pool.stats().bytesReserved, std::size_t(0));
+    QCOMPARE(pool.stats().peakBytesReserved, std::size_t(650));
+}
+
+QTEST_APPLESS_MAIN(tst_FrameMemory)
+
+#include "tst_framememory.moc"